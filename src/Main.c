@@ -47,12 +47,39 @@
 #include <errno.h>
  
 #include "Memory.h"
+#include "TelemetryHost.h"
+#include "Profiler.h"
 
 /**
  * \brief          Process ID of the target process
  */
 int g_pid;
 
+/**
+ * \brief                  Parses a decimal command line number
+ * \param[in] text         Argument text
+ * \param[out] value       Parsed number
+ * \return                 0 on success, 1 if the text isn't a number in range
+ */
+static int8_t parse_number(const char* text, uint32_t* value) {
+    unsigned long number = 0;
+    char* end = NULL;
+
+    if (text[0] < '0' || text[0] > '9') {
+        return 1;
+    }
+
+    errno = 0;
+    number = strtoul(text, &end, 10);
+    if (errno != 0 || *end != '\0' || number > UINT32_MAX) {
+        errno = 0;
+        return 1;
+    }
+
+    *value = (uint32_t)number;
+    return 0;
+}
+
 /**
  * \brief          Main function for library injection
  * \param[in] argc Number of command line arguments
@@ -60,8 +87,13 @@ int g_pid;
  * \return         0 on success, 1 on failure
  */
 int main(int argc, char *argv[]) {
-    char* library_path, * process_name = NULL;
+    char* library_path = NULL, * process_name = NULL;
     uintptr_t remote_addr = 0, dlopen_result = 0;
+    telemetry_consumer_t consumer = {0};
+    int8_t use_telemetry = 0, use_profiler = 0, profiler_option = 0, profiler_result = 1;
+    profiler_config_t profiler_config = {
+        PROFILER_DEFAULT_RATE, PROFILER_DEFAULT_DURATION, PROFILER_DEFAULT_MAX_STALL, PROFILER_DEFAULT_OUTPUT
+    };
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-p") == 0) {
@@ -88,12 +120,55 @@ int main(int argc, char *argv[]) {
                 fprintf(stderr, "Error: Missing argument for -l option\n");
                 goto cleanup;
             }
+        } else if (strcmp(argv[i], "-t") == 0) {
+            use_telemetry = 1;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            use_profiler = 1;
+        } else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-d") == 0
+                   || strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-o") == 0) {
+            uint32_t* number = NULL;
+
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: Missing argument for %s option\n", argv[i]);
+                goto cleanup;
+            }
+            switch (argv[i][1]) {
+                case 'r': number = &profiler_config.rate; break;
+                case 'd': number = &profiler_config.duration; break;
+                case 's': number = &profiler_config.max_stall; break;
+                case 'o': profiler_config.output_path = argv[i + 1]; break;
+            }
+            if (number != NULL && parse_number(argv[i + 1], number) != 0) {
+                fprintf(stderr, "Error: Invalid number '%s' for %s option\n", argv[i + 1], argv[i]);
+                goto cleanup;
+            }
+            profiler_option = 1;
+            i++;
+        } else {
+            fprintf(stderr, "Error: Unknown option %s\n", argv[i]);
+            goto cleanup;
         }
     }
 
-    if (process_name == NULL || library_path == NULL) {
-        fprintf(stderr, "Error: Please provide both -p and -l arguments\n");
-        fprintf(stderr, "Usage: %s -p <process_cmdline_content> -l <library_path>\n", argv[0]);
+    if (use_profiler == 1 && (library_path != NULL || use_telemetry == 1)) {
+        fprintf(stderr, "Error: -l and -t can't be combined with --profile\n");
+        goto cleanup;
+    }
+
+    if (use_profiler == 0 && profiler_option == 1) {
+        fprintf(stderr, "Error: -r, -d, -s and -o require --profile\n");
+        goto cleanup;
+    }
+
+    if (process_name == NULL || (library_path == NULL && use_profiler == 0)) {
+        if (use_profiler == 1) {
+            fprintf(stderr, "Error: Please provide the -p argument\n");
+        } else {
+            fprintf(stderr, "Error: Please provide both -p and -l arguments\n");
+        }
+        fprintf(stderr, "Usage: %s -p <process_cmdline_content> -l <library_path> [-t]\n", argv[0]);
+        fprintf(stderr, "       %s -p <process_cmdline_content> --profile [-r <rate_hz>] [-d <seconds>]"
+                " [-s <max_stall_us>] [-o <output_file>]\n", argv[0]);
         goto cleanup;
     }
 
@@ -103,6 +178,11 @@ int main(int argc, char *argv[]) {
         goto cleanup;
     }
 
+    if (use_profiler == 1) {
+        profiler_result = profile_process(g_pid, &profiler_config);
+        goto cleanup;
+    }
+
     if (ptrace(PTRACE_ATTACH, (pid_t)g_pid, NULL, NULL) == -1) {
         fprintf(stderr, "Error: Couldn't attach using ptrace: %s\n", strerror(errno));
         goto cleanup;
@@ -143,6 +223,10 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (use_telemetry == 1 && telemetry_host_create(remote_addr, TELEMETRY_DEFAULT_CAPACITY, &consumer) != 0) {
+        fprintf(stderr, "Error: Telemetry channel setup failed.\n\n");
+    }
+
 free_remote:
     if (remote_call((void*)free, 1, remote_addr) == 1) {
         fprintf(stderr, "Error: Remote free call failed.\n\n");
@@ -156,10 +240,18 @@ detach:
         goto cleanup;
     }
 
+    if (consumer.channel != NULL) {
+        telemetry_host_consume(&consumer, g_pid);
+    }
+
 cleanup:
+    telemetry_host_destroy(&consumer);
     free(process_name);
     free(library_path);
 
     printf("Info: Operation completed.\n");
+    if (use_profiler == 1) {
+        return profiler_result;
+    }
     return (errno) ? 1 : 0;
 }
\ No newline at end of file
@@ -48,6 +48,20 @@
 
 #include "Memory.h"
 
+/**
+ * \brief          Set by handle_stop to end the profiling and telemetry loops
+ */
+volatile sig_atomic_t g_stop;
+
+/**
+ * \brief                  SIGINT handler for the profiling and telemetry loops
+ * \param[in] signal       Signal number
+ */
+void handle_stop(int signal) {
+    (void)signal;
+    g_stop = 1;
+}
+
 /**
  * \brief  Finds process ID by command line content
  * \param[in] command_line_content  Command line content to match
@@ -247,27 +261,17 @@ uintptr_t get_remote_function_address(char* module_name, void* local_function_ad
 }
 
 /**
- * \brief                              Calls a function in remote process
- * \param[in] function_pointer         Pointer to the function
+ * \brief                              Calls a function at a remote address
+ * \param[in] remote_symbol_address    Remote address of the function
  * \param[in] count                    Argument count
- * \param[in] ...                      Arguments
+ * \param[in] arg_list                 Arguments
  * \return                             Return value from remote function, 1 on error
  */
-uintptr_t remote_call(void* function_pointer, int count, ...) {
-    char module_name[512];
+static uintptr_t remote_call_address_va(uintptr_t remote_symbol_address, int count, va_list arg_list) {
     struct user_regs_struct return_registers, original_registers, temp_registers;
-    uintptr_t space = sizeof(uintptr_t), return_address = 0, remote_symbol_address = 1;
+    uintptr_t space = sizeof(uintptr_t), return_address = 0;
     int status = 0;
 
-    if (get_local_module_name(function_pointer, module_name) != 0) {
-        return 1;
-    }
-    
-    remote_symbol_address = get_remote_function_address(module_name, function_pointer);
-    if (remote_symbol_address == 1) {
-        return 1;
-    }
-    
     if (ptrace(PTRACE_GETREGS, (pid_t)g_pid, NULL, &temp_registers) == -1) {
         fprintf(stderr, "Error: Couldn't get registers.\n");
         return 1;
@@ -279,8 +283,6 @@ uintptr_t remote_call(void* function_pointer, int count, ...) {
         temp_registers.rsp--;
     }
 
-    va_list arg_list;
-    va_start(arg_list, count);
     for (int i = 0; i < count && i < 6; i++) {
         uintptr_t argument = va_arg(arg_list, uintptr_t);
         switch (i) {
@@ -292,7 +294,6 @@ uintptr_t remote_call(void* function_pointer, int count, ...) {
             case 5: temp_registers.r9 = argument; break;
         }
     }
-    va_end(arg_list);
 
     temp_registers.rsp -= sizeof(uintptr_t);
     if (write_memory(g_pid, temp_registers.rsp, (uintptr_t)&return_address, sizeof(uintptr_t)) != 0) {
@@ -355,4 +356,48 @@ uintptr_t remote_call(void* function_pointer, int count, ...) {
     }
 
     return return_registers.rax;
+}
+
+/**
+ * \brief                              Calls a function in remote process
+ * \param[in] function_pointer         Pointer to the function
+ * \param[in] count                    Argument count
+ * \param[in] ...                      Arguments
+ * \return                             Return value from remote function, 1 on error
+ */
+uintptr_t remote_call(void* function_pointer, int count, ...) {
+    char module_name[512];
+    uintptr_t remote_symbol_address = 1, result = 1;
+    va_list arg_list;
+
+    if (get_local_module_name(function_pointer, module_name) != 0) {
+        return 1;
+    }
+    
+    remote_symbol_address = get_remote_function_address(module_name, function_pointer);
+    if (remote_symbol_address == 1) {
+        return 1;
+    }
+
+    va_start(arg_list, count);
+    result = remote_call_address_va(remote_symbol_address, count, arg_list);
+    va_end(arg_list);
+    return result;
+}
+
+/**
+ * \brief                              Calls a function at an address of the remote process
+ * \param[in] remote_symbol_address    Remote address of the function, e.g. from a remote dlsym
+ * \param[in] count                    Argument count
+ * \param[in] ...                      Arguments
+ * \return                             Return value from remote function, 1 on error
+ */
+uintptr_t remote_call_address(uintptr_t remote_symbol_address, int count, ...) {
+    uintptr_t result = 1;
+    va_list arg_list;
+
+    va_start(arg_list, count);
+    result = remote_call_address_va(remote_symbol_address, count, arg_list);
+    va_end(arg_list);
+    return result;
 }
\ No newline at end of file
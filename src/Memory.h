@@ -30,6 +30,10 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -43,8 +47,23 @@ int8_t get_local_module_name(void* address, char* module_name);
 uintptr_t get_base(int pid, const char* module_name, int8_t is_local);
 uintptr_t get_remote_function_address(char* module_name, void* local_function_address);
 uintptr_t remote_call(void* function_pointer, int count, ...);
+uintptr_t remote_call_address(uintptr_t remote_symbol_address, int count, ...);
+
+void handle_stop(int signal);
+
+/**
+ * \brief                  Gets the monotonic time, inline so Telemetry.c builds without Memory.c
+ * \return                 Time in nanoseconds
+ */
+static inline uint64_t get_time(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
 
 extern int g_pid;
+extern volatile sig_atomic_t g_stop;
 
 #ifdef __cplusplus
 }
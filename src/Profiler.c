@@ -0,0 +1,803 @@
+/**
+ * \file          Profiler.c
+ * \brief         Sampling profiler source file
+ */
+
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Frederic
+ 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <sys/user.h>
+#include <elf.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+
+#include "Memory.h"
+#include "Profiler.h"
+
+#define PROFILER_MAX_THREADS    256     /*!< Threads beyond this are not sampled */
+#define PROFILER_MAX_MODULES    1024    /*!< Executable mappings kept from the maps file */
+#define PROFILER_MAX_DEPTH      64      /*!< Frames kept per sample */
+#define PROFILER_SNAPSHOT_SIZE  8192    /*!< Stack bytes read at rsp with a single read */
+#define PROFILER_TABLE_SIZE     16384   /*!< Distinct stacks, has to be a power of two */
+#define PROFILER_DETACH_TIMEOUT 1000000000ULL   /*!< Nanoseconds to wait for threads to stop for detaching */
+
+/**
+ * \brief          What to do with a thread when its stop is reported
+ */
+typedef enum {
+    PROFILER_ACTION_RESUME,     /*!< Resume it, interrupt stops count as skipped */
+    PROFILER_ACTION_SAMPLE,     /*!< Sample interrupt stops within the stall limit, then resume */
+    PROFILER_ACTION_DETACH,     /*!< Detach, forwarding a pending signal */
+} profiler_action_t;
+
+/**
+ * \brief          Executable mapping of the target
+ */
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+    uintptr_t offset;
+    uintptr_t vaddr;            /*!< ELF virtual address of start, resolved before writing */
+    char path[256];
+} profiler_module_t;
+
+/**
+ * \brief          Traced thread of the target
+ */
+typedef struct {
+    pid_t tid;
+    int8_t alive;
+    int8_t interrupt_pending;
+    uint64_t interrupt_time;
+} profiler_thread_t;
+
+/**
+ * \brief          Distinct stack with its sample count, frames leaf first
+ */
+typedef struct {
+    uint64_t hash;
+    uint64_t count;
+    uint32_t depth;
+    uintptr_t frames[PROFILER_MAX_DEPTH];
+} profiler_stack_t;
+
+/**
+ * \brief          Profiler state
+ */
+typedef struct {
+    int pid;
+    uint64_t max_stall;
+    profiler_module_t modules[PROFILER_MAX_MODULES];
+    size_t module_count;
+    profiler_thread_t threads[PROFILER_MAX_THREADS];
+    size_t thread_count;
+    int8_t thread_limit_reported;
+    profiler_stack_t* stacks;
+    size_t stack_count;
+    uint64_t samples;
+    uint64_t skipped;
+    uint64_t lost;
+    uint64_t longest_stall;
+    uint64_t overruns;
+    uint64_t quiet_time;
+    sigset_t child_signal;
+} profiler_t;
+
+/**
+ * \brief                  Parses the executable mappings of the target
+ * \param[in] profiler     Profiler state
+ * \return                 0 on success, 1 on error
+ */
+static int8_t load_modules(profiler_t* profiler) {
+    char line[512], file_path[64];
+    FILE* fp = NULL;
+
+    snprintf(file_path, sizeof(file_path), "/proc/%d/maps", profiler->pid);
+    fp = fopen(file_path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Couldn't open maps file.\n");
+        return 1;
+    }
+
+    profiler->module_count = 0;
+    while (fgets(line, sizeof(line), fp) && profiler->module_count < PROFILER_MAX_MODULES) {
+        profiler_module_t* module = &profiler->modules[profiler->module_count];
+        char permissions[5] = {0}, * path = NULL, * new_line = NULL;
+
+        if (sscanf(line, "%lx-%lx %4s %lx", &module->start, &module->end, permissions, &module->offset) != 4
+            || permissions[2] != 'x') {
+            continue;
+        }
+
+        path = strchr(line, '/');
+        if (path == NULL) {
+            path = strchr(line, '[');
+        }
+        if (path == NULL) {
+            path = "[anon]";
+        }
+
+        snprintf(module->path, sizeof(module->path), "%s", path);
+        new_line = strchr(module->path, '\n');
+        if (new_line) {
+            *new_line = '\0';
+        }
+        profiler->module_count++;
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * \brief                  Finds the executable mapping containing an address
+ * \param[in] profiler     Profiler state
+ * \param[in] address      Address to look up
+ * \return                 Module or NULL if the address isn't executable
+ */
+static profiler_module_t* find_module(profiler_t* profiler, uintptr_t address) {
+    size_t low = 0, high = profiler->module_count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        profiler_module_t* module = &profiler->modules[middle];
+
+        if (address < module->start) {
+            high = middle;
+        } else if (address >= module->end) {
+            low = middle + 1;
+        } else {
+            return module;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief                  Frees the slots of threads that exited or can't be traced anymore
+ * \param[in] profiler     Profiler state
+ */
+static void remove_dead_threads(profiler_t* profiler) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        if (profiler->threads[i].alive == 1) {
+            profiler->threads[count++] = profiler->threads[i];
+        }
+    }
+    profiler->thread_count = count;
+}
+
+/**
+ * \brief                  Adds the target's threads that aren't traced yet
+ * \param[in] profiler     Profiler state
+ * \return                 0 on success, 1 if the target is gone
+ */
+static int8_t attach_threads(profiler_t* profiler) {
+    char file_path[64];
+    struct dirent* entry = NULL;
+    DIR* dir = NULL;
+
+    snprintf(file_path, sizeof(file_path), "/proc/%d/task", profiler->pid);
+    dir = opendir(file_path);
+    if (dir == NULL) {
+        return 1;
+    }
+
+    remove_dead_threads(profiler);
+    while ((entry = readdir(dir)) != NULL) {
+        pid_t tid = (pid_t)atoi(entry->d_name);
+        size_t i = 0;
+
+        if (tid <= 0) {
+            continue;
+        }
+
+        for (i = 0; i < profiler->thread_count; i++) {
+            if (profiler->threads[i].tid == tid) {
+                break;
+            }
+        }
+        if (i < profiler->thread_count) {
+            continue;
+        }
+
+        if (profiler->thread_count == PROFILER_MAX_THREADS) {
+            if (profiler->thread_limit_reported == 0) {
+                fprintf(stderr, "Warning: Target has more than %d threads, the rest isn't sampled.\n",
+                        PROFILER_MAX_THREADS);
+                profiler->thread_limit_reported = 1;
+            }
+            continue;
+        }
+
+        if (ptrace(PTRACE_SEIZE, tid, NULL, NULL) == -1) {
+            continue;
+        }
+        profiler->threads[profiler->thread_count].tid = tid;
+        profiler->threads[profiler->thread_count].alive = 1;
+        profiler->threads[profiler->thread_count].interrupt_pending = 0;
+        profiler->thread_count++;
+    }
+
+    closedir(dir);
+    return 0;
+}
+
+/**
+ * \brief                  Finds a traced thread
+ * \param[in] profiler     Profiler state
+ * \param[in] tid          Thread ID
+ * \return                 Thread or NULL if not traced
+ */
+static profiler_thread_t* find_thread(profiler_t* profiler, pid_t tid) {
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        if (profiler->threads[i].tid == tid) {
+            return &profiler->threads[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief                  Resumes a thread from any ptrace stop, forwarding signals
+ * \param[in] thread       Thread to resume
+ * \param[in] status       Status from waitpid
+ */
+static void resume_thread(profiler_thread_t* thread, int status) {
+    int signal = WSTOPSIG(status);
+
+    if ((status >> 16) == PTRACE_EVENT_STOP) {
+        /* Either stop is reported in place of a pending interrupt */
+        thread->interrupt_pending = 0;
+        if (signal == SIGSTOP || signal == SIGTSTP || signal == SIGTTIN || signal == SIGTTOU) {
+            ptrace(PTRACE_LISTEN, thread->tid, NULL, NULL);
+        } else {
+            ptrace(PTRACE_CONT, thread->tid, NULL, NULL);
+        }
+    } else {
+        ptrace(PTRACE_CONT, thread->tid, NULL, (void*)(uintptr_t)signal);
+    }
+}
+
+/**
+ * \brief                  Handles a waitpid status of a traced thread
+ * \param[in] thread       Thread the status belongs to
+ * \param[in] status       Status from waitpid
+ * \return                 1 if the thread is stopped, 0 otherwise
+ */
+static int8_t handle_status(profiler_thread_t* thread, int status) {
+    if (WIFEXITED(status) || WIFSIGNALED(status)) {
+        thread->alive = 0;
+        return 0;
+    }
+    return WIFSTOPPED(status) ? 1 : 0;
+}
+
+/**
+ * \brief                  Unwinds a stopped thread from one stack snapshot
+ * \param[in] profiler     Profiler state
+ * \param[in] registers    Registers of the stopped thread
+ * \param[in] deadline     Monotonic time at which unwinding has to stop
+ * \param[out] frames      Return addresses, leaf first
+ * \return                 Number of frames
+ */
+static uint32_t unwind_stack(profiler_t* profiler, struct user_regs_struct* registers, uint64_t deadline,
+                             uintptr_t* frames) {
+    static uintptr_t snapshot[PROFILER_SNAPSHOT_SIZE / sizeof(uintptr_t)];
+    uintptr_t stack_start = registers->rsp, stack_end = 0, frame_pointer = registers->rbp;
+    size_t length = PROFILER_SNAPSHOT_SIZE;
+    uint32_t depth = 0;
+
+    frames[depth++] = registers->rip;
+
+    /* Shrink the read until it fits below the end of the stack mapping */
+    while (length >= 512 && read_memory(profiler->pid, stack_start, (uintptr_t)snapshot, length) != 0
+           && get_time() <= deadline) {
+        length /= 2;
+    }
+    if (length < 512 || get_time() > deadline) {
+        return depth;
+    }
+    stack_end = stack_start + length;
+
+    /* Frame pointer chain, as long as it stays inside the snapshot */
+    while (depth < PROFILER_MAX_DEPTH && frame_pointer >= stack_start
+           && frame_pointer + 2 * sizeof(uintptr_t) <= stack_end && (frame_pointer & 7) == 0) {
+        uintptr_t* frame = &snapshot[(frame_pointer - stack_start) / sizeof(uintptr_t)];
+
+        if (find_module(profiler, frame[1]) == NULL) {
+            break;
+        }
+        frames[depth++] = frame[1];
+
+        /* The outermost frames often leave rbp unset, their return address is still valid */
+        if (frame[0] <= frame_pointer || (frame[0] & 7) != 0) {
+            break;
+        }
+        frame_pointer = frame[0];
+    }
+
+    if (depth > 1) {
+        return depth;
+    }
+
+    /* No usable frame pointers, fall back to scanning for return addresses */
+    for (size_t i = 0; i < length / sizeof(uintptr_t) && depth < PROFILER_MAX_DEPTH; i++) {
+        if ((i & 63) == 0 && get_time() > deadline) {
+            break;
+        }
+        if (find_module(profiler, snapshot[i]) != NULL) {
+            frames[depth++] = snapshot[i];
+        }
+    }
+    return depth;
+}
+
+/**
+ * \brief                  Counts a sample for its stack
+ * \param[in] profiler     Profiler state
+ * \param[in] frames       Return addresses, leaf first
+ * \param[in] depth        Number of frames
+ */
+static void record_stack(profiler_t* profiler, uintptr_t* frames, uint32_t depth) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t index = 0;
+
+    for (uint32_t i = 0; i < depth; i++) {
+        hash = (hash ^ frames[i]) * 0x100000001b3ULL;
+    }
+
+    index = hash & (PROFILER_TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < PROFILER_TABLE_SIZE; probe++) {
+        profiler_stack_t* stack = &profiler->stacks[(index + probe) & (PROFILER_TABLE_SIZE - 1)];
+
+        if (stack->count == 0) {
+            stack->hash = hash;
+            stack->depth = depth;
+            memcpy(stack->frames, frames, depth * sizeof(uintptr_t));
+            stack->count = 1;
+            profiler->stack_count++;
+            return;
+        }
+        if (stack->hash == hash && stack->depth == depth
+            && memcmp(stack->frames, frames, depth * sizeof(uintptr_t)) == 0) {
+            stack->count++;
+            return;
+        }
+    }
+    profiler->lost++;
+}
+
+/**
+ * \brief                  Records the stack of a thread in its interrupt stop if the stall limit allows it
+ * \param[in] profiler     Profiler state
+ * \param[in] thread       Stopped thread
+ */
+static void sample_thread(profiler_t* profiler, profiler_thread_t* thread) {
+    uintptr_t frames[PROFILER_MAX_DEPTH];
+    struct user_regs_struct registers;
+    uint64_t deadline = thread->interrupt_time + profiler->max_stall;
+    uint32_t depth = 0;
+
+    if (get_time() > deadline || ptrace(PTRACE_GETREGS, thread->tid, NULL, &registers) == -1) {
+        profiler->skipped++;
+        return;
+    }
+
+    depth = unwind_stack(profiler, &registers, deadline, frames);
+    record_stack(profiler, frames, depth);
+    profiler->samples++;
+}
+
+/**
+ * \brief                  Handles one stop or exit of a traced thread and resumes it
+ * \param[in] profiler     Profiler state
+ * \param[in] thread       Thread the status belongs to
+ * \param[in] status       Status from waitpid
+ * \param[in] action       What to do with the stopped thread
+ */
+static void handle_event(profiler_t* profiler, profiler_thread_t* thread, int status, profiler_action_t action) {
+    uint64_t stopped_since = 0, stall = 0;
+    int8_t interrupt_stop = 0;
+
+    if (handle_status(thread, status) == 0) {
+        return;
+    }
+
+    if (action == PROFILER_ACTION_DETACH) {
+        int signal = ((status >> 16) == PTRACE_EVENT_STOP) ? 0 : WSTOPSIG(status);
+
+        if (ptrace(PTRACE_DETACH, thread->tid, NULL, (void*)(uintptr_t)signal) == -1) {
+            fprintf(stderr, "Error: Couldn't detach thread %d: %s\n", (int)thread->tid, strerror(errno));
+        }
+        thread->alive = 0;
+        return;
+    }
+
+    interrupt_stop = (thread->interrupt_pending == 1 && (status >> 16) == PTRACE_EVENT_STOP
+                      && WSTOPSIG(status) == SIGTRAP) ? 1 : 0;
+    if (interrupt_stop == 1) {
+        if (action == PROFILER_ACTION_SAMPLE) {
+            sample_thread(profiler, thread);
+        } else {
+            profiler->skipped++;
+        }
+    }
+    resume_thread(thread, status);
+
+    if (interrupt_stop == 1) {
+        /* The thread can't have stopped before the interrupt or before the last poll that saw no stop */
+        stopped_since = (thread->interrupt_time > profiler->quiet_time) ? thread->interrupt_time
+                                                                        : profiler->quiet_time;
+        stall = get_time() - stopped_since;
+        if (stall > profiler->longest_stall) {
+            profiler->longest_stall = stall;
+        }
+        if (stall > profiler->max_stall) {
+            profiler->overruns++;
+        }
+    }
+}
+
+/**
+ * \brief                  Checks for interrupts whose stop hasn't been seen yet
+ * \param[in] profiler     Profiler state
+ * \return                 1 if an interrupt is pending, 0 otherwise
+ */
+static int8_t has_pending_interrupt(profiler_t* profiler) {
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        if (profiler->threads[i].alive == 1 && profiler->threads[i].interrupt_pending == 1) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief                  Checks for threads that are still traced
+ * \param[in] profiler     Profiler state
+ * \return                 1 if a thread is traced, 0 otherwise
+ */
+static int8_t has_alive_thread(profiler_t* profiler) {
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        if (profiler->threads[i].alive == 1) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief                  Handles stops until a deadline, sleeping on SIGCHLD in between
+ * \param[in] profiler     Profiler state
+ * \param[in] deadline     Monotonic time in nanoseconds
+ * \param[in] action       What to do with stopped threads, sampling returns once no interrupt is pending,
+ *                         detaching once no thread is traced and resuming early on SIGINT
+ */
+static void wait_for_stops(profiler_t* profiler, uint64_t deadline, profiler_action_t action) {
+    for (;;) {
+        uint64_t now = get_time(), remaining = 0;
+        struct timespec timeout;
+        int status = 0;
+        pid_t tid = 0;
+
+        while ((tid = waitpid(-1, &status, __WALL | WNOHANG)) > 0) {
+            profiler_thread_t* thread = find_thread(profiler, tid);
+
+            if (thread != NULL) {
+                handle_event(profiler, thread, status, action);
+            }
+            now = get_time();
+        }
+        if (tid == -1) {
+            return;
+        }
+        profiler->quiet_time = now;
+
+        if ((action == PROFILER_ACTION_SAMPLE && has_pending_interrupt(profiler) == 0)
+            || (action == PROFILER_ACTION_DETACH && has_alive_thread(profiler) == 0)) {
+            return;
+        }
+
+        now = get_time();
+        if (now >= deadline || (action == PROFILER_ACTION_RESUME && g_stop == 1)) {
+            return;
+        }
+
+        remaining = deadline - now;
+        timeout.tv_sec = (time_t)(remaining / 1000000000ULL);
+        timeout.tv_nsec = (long)(remaining % 1000000000ULL);
+        sigtimedwait(&profiler->child_signal, NULL, &timeout);
+    }
+}
+
+/**
+ * \brief                  Interrupts all threads at once and samples those that stop within the stall limit
+ * \param[in] profiler     Profiler state
+ */
+static void sample_threads(profiler_t* profiler) {
+    uint64_t now = get_time();
+
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        profiler_thread_t* thread = &profiler->threads[i];
+
+        /* A late stop of an earlier interrupt is still pending, it is resumed without sampling */
+        if (thread->alive == 0 || thread->interrupt_pending == 1) {
+            continue;
+        }
+
+        if (ptrace(PTRACE_INTERRUPT, thread->tid, NULL, NULL) == -1) {
+            thread->alive = 0;
+            continue;
+        }
+        thread->interrupt_pending = 1;
+        thread->interrupt_time = now;
+    }
+
+    wait_for_stops(profiler, now + profiler->max_stall, PROFILER_ACTION_SAMPLE);
+}
+
+/**
+ * \brief                  Stops and detaches every traced thread without waiting indefinitely
+ * \param[in] profiler     Profiler state
+ */
+static void detach_threads(profiler_t* profiler) {
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        profiler_thread_t* thread = &profiler->threads[i];
+
+        if (thread->alive == 0 || thread->interrupt_pending == 1) {
+            continue;
+        }
+
+        if (ptrace(PTRACE_INTERRUPT, thread->tid, NULL, NULL) == -1) {
+            thread->alive = 0;
+            continue;
+        }
+        thread->interrupt_pending = 1;
+    }
+
+    wait_for_stops(profiler, get_time() + PROFILER_DETACH_TIMEOUT, PROFILER_ACTION_DETACH);
+
+    for (size_t i = 0; i < profiler->thread_count; i++) {
+        if (profiler->threads[i].alive == 1) {
+            fprintf(stderr, "Error: Thread %d didn't stop for detaching, it is released when the injector exits.\n",
+                    (int)profiler->threads[i].tid);
+        }
+    }
+}
+
+/**
+ * \brief                  Translates the start of a mapping to the ELF virtual address addr2line expects
+ * \param[in] profiler     Profiler state
+ * \param[in] module       Module to resolve, keeps its file offset if the file isn't a readable ELF
+ */
+static void resolve_module_vaddr(profiler_t* profiler, profiler_module_t* module) {
+    char file_path[320];
+    Elf64_Ehdr header;
+    Elf64_Phdr segment;
+    uintptr_t page_mask = ~((uintptr_t)sysconf(_SC_PAGESIZE) - 1);
+    int fd = -1;
+
+    module->vaddr = module->offset;
+    if (module->path[0] != '/') {
+        return;
+    }
+
+    /* Go through the root of the target so paths inside containers resolve */
+    snprintf(file_path, sizeof(file_path), "/proc/%d/root%s", profiler->pid, module->path);
+    fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return;
+    }
+
+    if (pread(fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.e_ident, ELFMAG, SELFMAG) != 0
+        || header.e_ident[EI_CLASS] != ELFCLASS64 || header.e_phentsize != sizeof(Elf64_Phdr)) {
+        close(fd);
+        return;
+    }
+
+    for (uint16_t i = 0; i < header.e_phnum; i++) {
+        if (pread(fd, &segment, sizeof(segment), (off_t)(header.e_phoff + i * sizeof(segment))) != sizeof(segment)) {
+            break;
+        }
+        /* The mapping starts at the page holding p_offset, p_vaddr has the same offset in its page */
+        if (segment.p_type == PT_LOAD && (segment.p_flags & PF_X) != 0 && module->offset >= (segment.p_offset & page_mask)
+            && module->offset < segment.p_offset + segment.p_filesz) {
+            module->vaddr = module->offset - segment.p_offset + segment.p_vaddr;
+            break;
+        }
+    }
+    close(fd);
+}
+
+/**
+ * \brief                  Writes one frame as module+address, the ELF virtual address within the module
+ * \param[in] profiler     Profiler state
+ * \param[in] fp           Output file
+ * \param[in] address      Frame address
+ */
+static void write_frame(profiler_t* profiler, FILE* fp, uintptr_t address) {
+    profiler_module_t* module = find_module(profiler, address);
+    const char* name = NULL;
+
+    if (module == NULL) {
+        fprintf(fp, "0x%lx", address);
+        return;
+    }
+
+    name = strrchr(module->path, '/');
+    name = (name != NULL) ? name + 1 : module->path;
+    fprintf(fp, "%s+0x%lx", name, address - module->start + module->vaddr);
+}
+
+/**
+ * \brief                  Writes all stacks in folded format, root first
+ * \param[in] profiler     Profiler state
+ * \param[in] output_path  Output file
+ * \return                 0 on success, 1 on error
+ */
+static int8_t write_folded(profiler_t* profiler, const char* output_path) {
+    FILE* fp = fopen(output_path, "w");
+
+    if (fp == NULL) {
+        fprintf(stderr, "Error: Couldn't open output file %s: %s\n", output_path, strerror(errno));
+        return 1;
+    }
+
+    for (size_t i = 0; i < profiler->module_count; i++) {
+        resolve_module_vaddr(profiler, &profiler->modules[i]);
+    }
+
+    for (size_t i = 0; i < PROFILER_TABLE_SIZE; i++) {
+        profiler_stack_t* stack = &profiler->stacks[i];
+
+        if (stack->count == 0) {
+            continue;
+        }
+
+        for (uint32_t frame = stack->depth; frame-- > 0;) {
+            /* Return addresses point behind the call, step back into it */
+            write_frame(profiler, fp, (frame == 0) ? stack->frames[frame] : stack->frames[frame] - 1);
+            if (frame > 0) {
+                fputc(';', fp);
+            }
+        }
+        fprintf(fp, " %llu\n", (unsigned long long)stack->count);
+    }
+
+    fclose(fp);
+    printf("Info: Folded stacks written to %s.\n\n", output_path);
+    return 0;
+}
+
+/**
+ * \brief                  Samples the stacks of all threads of a process via ptrace
+ * \param[in] pid          Process ID of the target
+ * \param[in] config       Profiler settings
+ * \return                 0 on success, 1 on error
+ */
+int8_t profile_process(int pid, const profiler_config_t* config) {
+    struct sigaction action = {0}, previous_action;
+    sigset_t previous_mask;
+    uint64_t interval = 0, now = 0, next = 0, end = 0, last_refresh = 0;
+    profiler_t* profiler = NULL;
+    int8_t result = 1;
+
+    if (config->rate == 0 || config->rate > 10000 || config->duration == 0 || config->max_stall == 0) {
+        fprintf(stderr, "Error: Sampling rate has to be 1-10000 Hz, duration and stall limit above 0.\n");
+        return 1;
+    }
+
+    profiler = calloc(1, sizeof(profiler_t));
+    if (profiler != NULL) {
+        profiler->stacks = calloc(PROFILER_TABLE_SIZE, sizeof(profiler_stack_t));
+    }
+    if (profiler == NULL || profiler->stacks == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        goto cleanup;
+    }
+    profiler->pid = pid;
+    profiler->max_stall = (uint64_t)config->max_stall * 1000ULL;
+
+    if (load_modules(profiler) != 0 || attach_threads(profiler) != 0 || profiler->thread_count == 0) {
+        fprintf(stderr, "Error: Couldn't attach to threads of %d: %s\n", pid, strerror(errno));
+        goto cleanup;
+    }
+
+    g_stop = 0;
+    action.sa_handler = handle_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &previous_action);
+
+    /* Tracee stops raise SIGCHLD, keep it pending so sigtimedwait wakes up on them */
+    sigemptyset(&profiler->child_signal);
+    sigaddset(&profiler->child_signal, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &profiler->child_signal, &previous_mask);
+
+    printf("Info: Profiling %zu threads at %u Hz for %u s, stall limit %u us.\n\n",
+           profiler->thread_count, config->rate, config->duration, config->max_stall);
+
+    interval = 1000000000ULL / config->rate;
+    now = next = last_refresh = get_time();
+    end = now + (uint64_t)config->duration * 1000000000ULL;
+
+    while (g_stop == 0 && now < end) {
+        if (now - last_refresh >= 1000000000ULL) {
+            if (attach_threads(profiler) != 0) {
+                break;
+            }
+            load_modules(profiler);
+            last_refresh = now;
+        }
+
+        sample_threads(profiler);
+
+        /* Ticks missed by a slow round are dropped instead of sampled back to back */
+        now = get_time();
+        next += interval;
+        if (next < now) {
+            next = now;
+        }
+
+        /* Always polls once, even when no time is left until the next tick */
+        wait_for_stops(profiler, next, PROFILER_ACTION_RESUME);
+        now = get_time();
+    }
+
+    detach_threads(profiler);
+    sigprocmask(SIG_SETMASK, &previous_mask, NULL);
+    sigaction(SIGINT, &previous_action, NULL);
+
+    /* Symbolize against the latest module map once the target runs freely again */
+    load_modules(profiler);
+    result = write_folded(profiler, config->output_path);
+
+    printf("Info: %llu samples, %zu distinct stacks, %llu skipped over stall limit, %llu lost.\n",
+           (unsigned long long)profiler->samples, profiler->stack_count, (unsigned long long)profiler->skipped,
+           (unsigned long long)profiler->lost);
+    printf("Info: Longest stall %llu us, %llu stops took longer than the stall limit.\n\n",
+           (unsigned long long)(profiler->longest_stall / 1000ULL), (unsigned long long)profiler->overruns);
+
+cleanup:
+    if (profiler != NULL) {
+        free(profiler->stacks);
+    }
+    free(profiler);
+    return result;
+}
@@ -0,0 +1,73 @@
+/**
+ * \file          Profiler.h
+ * \brief         Sampling profiler header file
+ */
+
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Frederic
+ 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Default samples per second for every thread
+ */
+#define PROFILER_DEFAULT_RATE       99U
+
+/**
+ * \brief          Default profiling duration in seconds
+ */
+#define PROFILER_DEFAULT_DURATION   10U
+
+/**
+ * \brief          Default limit in microseconds a thread may stay stopped per sample
+ */
+#define PROFILER_DEFAULT_MAX_STALL  200U
+
+/**
+ * \brief          Default folded stacks output file
+ */
+#define PROFILER_DEFAULT_OUTPUT     "profile.folded"
+
+/**
+ * \brief          Profiler settings
+ */
+typedef struct {
+    uint32_t rate;              /*!< Samples per second for every thread */
+    uint32_t duration;          /*!< Profiling duration in seconds */
+    uint32_t max_stall;         /*!< Microseconds a thread may stay stopped per sample */
+    const char* output_path;    /*!< Folded stacks output file */
+} profiler_config_t;
+
+int8_t profile_process(int pid, const profiler_config_t* config);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* PROFILER_H */
@@ -0,0 +1,191 @@
+/**
+ * \file          Telemetry.c
+ * \brief         Shared memory telemetry ring source file
+ */
+
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Frederic
+ 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Memory.h"
+#include "Telemetry.h"
+
+_Static_assert(sizeof(telemetry_slot_t) == 64, "A slot has to fill exactly one cache line");
+
+/**
+ * \brief                  Gets the slot array following the header
+ * \param[in] channel      Telemetry channel
+ * \return                 Pointer to the first slot
+ */
+static telemetry_slot_t* get_slots(telemetry_channel_t* channel) {
+    return (telemetry_slot_t*)((uint8_t*)channel + sizeof(telemetry_channel_t));
+}
+
+/**
+ * \brief                  Computes the region size needed for a ring
+ * \param[in] capacity     Number of slots
+ * \return                 Size in bytes
+ */
+size_t telemetry_region_size(uint32_t capacity) {
+    return sizeof(telemetry_channel_t) + (size_t)capacity * sizeof(telemetry_slot_t);
+}
+
+/**
+ * \brief                  Initializes a fresh region, done once by the consumer
+ * \param[out] consumer    Consumer state, the header isn't trusted afterwards
+ * \param[in] region       Start of the shared mapping
+ * \param[in] size         Size of the mapping
+ * \param[in] capacity     Number of slots, has to be a power of two
+ * \return                 0 on success, 1 on error
+ */
+int8_t telemetry_init(telemetry_consumer_t* consumer, void* region, size_t size, uint32_t capacity) {
+    telemetry_channel_t* channel = region;
+    telemetry_slot_t* slots = NULL;
+
+    if (region == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0
+        || size < telemetry_region_size(capacity)) {
+        return 1;
+    }
+
+    slots = get_slots(channel);
+    for (uint32_t i = 0; i < capacity; i++) {
+        __atomic_store_n(&slots[i].sequence, i, __ATOMIC_RELAXED);
+    }
+
+    channel->version = TELEMETRY_VERSION;
+    channel->capacity = capacity;
+    channel->slot_size = sizeof(telemetry_slot_t);
+    __atomic_store_n(&channel->enqueue_position, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&channel->dropped, 0, __ATOMIC_RELAXED);
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    channel->magic = TELEMETRY_MAGIC;
+
+    consumer->channel = channel;
+    consumer->size = size;
+    consumer->capacity = capacity;
+    consumer->position = 0;
+    return 0;
+}
+
+/**
+ * \brief                  Validates an initialized region, done by the producer
+ * \param[in] region       Start of the shared mapping
+ * \param[in] size         Size of the mapping
+ * \return                 Channel on success, NULL on error
+ */
+telemetry_channel_t* telemetry_attach(void* region, size_t size) {
+    telemetry_channel_t* channel = region;
+
+    if (region == NULL || size < sizeof(telemetry_channel_t)) {
+        return NULL;
+    }
+
+    if (channel->magic != TELEMETRY_MAGIC || channel->version != TELEMETRY_VERSION
+        || channel->slot_size != sizeof(telemetry_slot_t)
+        || channel->capacity == 0 || (channel->capacity & (channel->capacity - 1)) != 0
+        || size < telemetry_region_size(channel->capacity)) {
+        return NULL;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return channel;
+}
+
+/**
+ * \brief                  Appends a record, safe to call from any number of threads
+ * \param[in] channel      Telemetry channel
+ * \param[in] id           Caller defined record ID
+ * \param[in] data         Payload, truncated to TELEMETRY_PAYLOAD_SIZE
+ * \param[in] length       Payload length
+ * \return                 0 on success, 1 if the ring is full and the record was dropped
+ */
+int8_t telemetry_push(telemetry_channel_t* channel, uint32_t id, const void* data, uint32_t length) {
+    telemetry_slot_t* slots = get_slots(channel), * slot = NULL;
+    uint64_t mask = channel->capacity - 1;
+    uint64_t position = __atomic_load_n(&channel->enqueue_position, __ATOMIC_RELAXED);
+
+    for (;;) {
+        slot = &slots[position & mask];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t difference = (int64_t)(sequence - position);
+
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&channel->enqueue_position, &position, position + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            __atomic_fetch_add(&channel->dropped, 1, __ATOMIC_RELAXED);
+            return 1;
+        } else {
+            position = __atomic_load_n(&channel->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (length > TELEMETRY_PAYLOAD_SIZE) {
+        length = TELEMETRY_PAYLOAD_SIZE;
+    }
+
+    slot->timestamp = get_time();
+    slot->id = id;
+    slot->length = length;
+    if (length > 0) {
+        memcpy(slot->payload, data, length);
+    }
+
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/**
+ * \brief                  Takes the oldest record, only one consumer may call this
+ * \param[in] consumer     Consumer state from telemetry_init
+ * \param[out] record      Copy of the record
+ * \return                 0 on success, 1 if the ring is empty
+ */
+int8_t telemetry_pop(telemetry_consumer_t* consumer, telemetry_record_t* record) {
+    telemetry_channel_t* channel = consumer->channel;
+    telemetry_slot_t* slots = get_slots(channel), * slot = NULL;
+    uint64_t position = consumer->position;
+
+    slot = &slots[position & (consumer->capacity - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1) {
+        return 1;
+    }
+
+    record->timestamp = slot->timestamp;
+    record->id = slot->id;
+    record->length = (slot->length > TELEMETRY_PAYLOAD_SIZE) ? TELEMETRY_PAYLOAD_SIZE : slot->length;
+    memcpy(record->payload, slot->payload, record->length);
+
+    __atomic_store_n(&slot->sequence, position + consumer->capacity, __ATOMIC_RELEASE);
+    consumer->position = position + 1;
+    return 0;
+}
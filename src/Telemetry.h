@@ -0,0 +1,130 @@
+/**
+ * \file          Telemetry.h
+ * \brief         Shared memory telemetry ring header file
+ */
+
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Frederic
+ 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief          Magic value at the start of a telemetry region ("PTIT")
+ */
+#define TELEMETRY_MAGIC             0x54495450U
+
+/**
+ * \brief          Layout version of the telemetry region
+ */
+#define TELEMETRY_VERSION           2U
+
+/**
+ * \brief          Default number of records in the ring, has to be a power of two
+ */
+#define TELEMETRY_DEFAULT_CAPACITY  65536U
+
+/**
+ * \brief          Maximum payload bytes carried by a single record
+ */
+#define TELEMETRY_PAYLOAD_SIZE      40U
+
+/**
+ * \brief          Name of the function the injected library exports to receive the region
+ */
+#define TELEMETRY_INIT_SYMBOL       "injector_telemetry_init"
+
+/**
+ * \brief          Cache line alignment for shared fields, usable from C and C++
+ */
+#define TELEMETRY_CACHE_LINE        __attribute__((aligned(64)))
+
+/*
+ * The shared fields are plain integers so the header can be included from C and C++,
+ * they are only accessed through the __atomic builtins in Telemetry.c.
+ */
+
+/**
+ * \brief          Single ring slot, exactly one cache line
+ */
+typedef struct {
+    uint64_t sequence TELEMETRY_CACHE_LINE;
+    uint64_t timestamp;
+    uint32_t id;
+    uint32_t length;
+    uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+} telemetry_slot_t;
+
+/**
+ * \brief          Shared region header, followed directly by the slots
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    uint64_t enqueue_position TELEMETRY_CACHE_LINE;
+    uint64_t dropped TELEMETRY_CACHE_LINE;
+} telemetry_channel_t;
+
+/**
+ * \brief          Record as handed out to the consumer
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint32_t id;
+    uint32_t length;
+    uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+} telemetry_record_t;
+
+/**
+ * \brief          Consumer view of a region, kept in private memory since the producer can write the header
+ */
+typedef struct {
+    telemetry_channel_t* channel;   /*!< Start of the shared mapping */
+    size_t size;                    /*!< Size of the mapping */
+    uint32_t capacity;              /*!< Number of slots as initialized */
+    uint64_t position;              /*!< Next position to dequeue */
+} telemetry_consumer_t;
+
+size_t telemetry_region_size(uint32_t capacity);
+
+int8_t telemetry_init(telemetry_consumer_t* consumer, void* region, size_t size, uint32_t capacity);
+telemetry_channel_t* telemetry_attach(void* region, size_t size);
+
+int8_t telemetry_push(telemetry_channel_t* channel, uint32_t id, const void* data, uint32_t length);
+int8_t telemetry_pop(telemetry_consumer_t* consumer, telemetry_record_t* record);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TELEMETRY_H */
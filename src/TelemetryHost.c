@@ -0,0 +1,200 @@
+/**
+ * \file          TelemetryHost.c
+ * \brief         Injector side telemetry source file
+ */
+
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Frederic
+ 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+
+#include "Memory.h"
+#include "TelemetryHost.h"
+
+/**
+ * \brief          Name of the memfd as shown in /proc/pid/fd of the target
+ */
+#define TELEMETRY_MEMFD_NAME    "ptrace-injector-telemetry"
+
+/**
+ * \brief                  Creates the telemetry region in the target and hands it to the injected library
+ * \param[in] remote_buffer Remote scratch buffer of at least 256 bytes
+ * \param[in] capacity     Number of ring slots, has to be a power of two
+ * \param[out] consumer    Consumer state of the locally mapped region
+ * \return                 0 on success, 1 on error
+ */
+int8_t telemetry_host_create(uintptr_t remote_buffer, uint32_t capacity, telemetry_consumer_t* consumer) {
+    char file_path[64], link_target[128];
+    size_t size = telemetry_region_size(capacity);
+    ssize_t link_length = 0;
+    uintptr_t init_address = 0;
+    void* region = MAP_FAILED;
+    int remote_fd = -1, local_fd = -1;
+    int8_t result = 1;
+
+    if (write_memory(g_pid, remote_buffer, (uintptr_t)TELEMETRY_MEMFD_NAME, sizeof(TELEMETRY_MEMFD_NAME)) != 0) {
+        fprintf(stderr, "Error: Writing telemetry memfd name failed: %s\n\n", strerror(errno));
+        return 1;
+    }
+
+    remote_fd = (int)remote_call((void*)memfd_create, 2, remote_buffer, (uintptr_t)MFD_CLOEXEC);
+    if (remote_fd < 0) {
+        fprintf(stderr, "Error: Remote memfd_create failed.\n\n");
+        return 1;
+    }
+
+    /* remote_call also returns 1 on its own errors, so make sure the fd really is the memfd */
+    snprintf(file_path, sizeof(file_path), "/proc/%d/fd/%d", g_pid, remote_fd);
+    link_length = readlink(file_path, link_target, sizeof(link_target) - 1);
+    link_target[(link_length > 0) ? link_length : 0] = '\0';
+    if (strcmp(link_target, "/memfd:" TELEMETRY_MEMFD_NAME " (deleted)") != 0) {
+        fprintf(stderr, "Error: Remote memfd_create failed.\n\n");
+        return 1;
+    }
+
+    if (remote_call((void*)ftruncate, 2, (uintptr_t)remote_fd, (uintptr_t)size) != 0) {
+        fprintf(stderr, "Error: Remote ftruncate failed.\n\n");
+        goto close_remote;
+    }
+
+    local_fd = open(file_path, O_RDWR | O_CLOEXEC);
+    if (local_fd == -1) {
+        fprintf(stderr, "Error: Couldn't open telemetry memfd: %s\n\n", strerror(errno));
+        goto close_remote;
+    }
+
+    region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, local_fd, 0);
+    close(local_fd);
+    if (region == MAP_FAILED) {
+        fprintf(stderr, "Error: Couldn't map telemetry region: %s\n\n", strerror(errno));
+        goto close_remote;
+    }
+
+    if (telemetry_init(consumer, region, size, capacity) != 0) {
+        fprintf(stderr, "Error: Invalid telemetry capacity %u.\n\n", capacity);
+        goto unmap;
+    }
+
+    if (write_memory(g_pid, remote_buffer, (uintptr_t)TELEMETRY_INIT_SYMBOL, sizeof(TELEMETRY_INIT_SYMBOL)) != 0) {
+        fprintf(stderr, "Error: Writing telemetry init symbol failed: %s\n\n", strerror(errno));
+        goto unmap;
+    }
+
+    init_address = remote_call((void*)dlsym, 2, (uintptr_t)RTLD_DEFAULT, remote_buffer);
+    if (init_address == 0 || init_address == 1) {
+        fprintf(stderr, "Error: Library doesn't export %s.\n\n", TELEMETRY_INIT_SYMBOL);
+        goto unmap;
+    }
+
+    if ((int)remote_call_address(init_address, 2, (uintptr_t)remote_fd, (uintptr_t)size) != 0) {
+        fprintf(stderr, "Error: %s failed in target process.\n\n", TELEMETRY_INIT_SYMBOL);
+        goto unmap;
+    }
+
+    printf("Info: Telemetry channel with %u slots handed to library.\n\n", capacity);
+    result = 0;
+
+unmap:
+    if (result != 0) {
+        munmap(region, size);
+        consumer->channel = NULL;
+    }
+
+close_remote:
+    if (remote_call((void*)close, 1, (uintptr_t)remote_fd) != 0) {
+        fprintf(stderr, "Error: Remote close call failed.\n\n");
+    }
+
+    return result;
+}
+
+/**
+ * \brief                  Prints records until SIGINT or until the target exits
+ * \param[in] consumer     Consumer state from telemetry_host_create
+ * \param[in] pid          Process ID of the producing target
+ */
+void telemetry_host_consume(telemetry_consumer_t* consumer, int pid) {
+    struct sigaction action = {0}, previous_action;
+    struct timespec idle = {0, 1000000};
+    telemetry_record_t record;
+    uint64_t received = 0;
+    int saved_errno = errno;
+
+    g_stop = 0;
+    action.sa_handler = handle_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &previous_action);
+
+    printf("Info: Consuming telemetry, press Ctrl+C to stop.\n\n");
+    while (g_stop == 0) {
+        if (telemetry_pop(consumer, &record) != 0) {
+            if (kill((pid_t)pid, 0) == -1 && errno == ESRCH) {
+                break;
+            }
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < record.length; i++) {
+            if (!isprint(record.payload[i])) {
+                record.payload[i] = '.';
+            }
+        }
+        printf("Telemetry: [%llu.%09llu] %u: %.*s\n",
+               (unsigned long long)(record.timestamp / 1000000000ULL),
+               (unsigned long long)(record.timestamp % 1000000000ULL),
+               record.id, (int)record.length, (char*)record.payload);
+        received++;
+    }
+
+    sigaction(SIGINT, &previous_action, NULL);
+    printf("\nInfo: Received %llu telemetry records, %llu dropped.\n\n", (unsigned long long)received,
+           (unsigned long long)__atomic_load_n(&consumer->channel->dropped, __ATOMIC_RELAXED));
+    errno = saved_errno;
+}
+
+/**
+ * \brief                  Unmaps the local view of the telemetry region
+ * \param[in] consumer     Consumer state from telemetry_host_create
+ */
+void telemetry_host_destroy(telemetry_consumer_t* consumer) {
+    if (consumer->channel != NULL) {
+        munmap(consumer->channel, consumer->size);
+        consumer->channel = NULL;
+    }
+}
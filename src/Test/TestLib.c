@@ -27,10 +27,50 @@
  * SOFTWARE.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/mman.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <pthread.h>
 
+#include "../Telemetry.h"
+
+/**
+ * \brief          Telemetry channel handed over by the injector, NULL if not attached
+ */
+static _Atomic(telemetry_channel_t*) g_channel;
+
+/**
+ * \brief                  Receives the telemetry region from the injector, called through remote_call
+ * \param[in] fd           memfd of the region, closed by the injector afterwards
+ * \param[in] size         Size of the region
+ * \return                 0 on success, 1 on error or if a channel is already attached
+ */
+int injector_telemetry_init(int fd, size_t size) {
+    telemetry_channel_t* channel = NULL, * expected = NULL;
+    void* region = NULL;
+
+    if (atomic_load(&g_channel) != NULL) {
+        return 1;
+    }
+
+    region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        return 1;
+    }
+
+    /* The first channel stays for the lifetime of the library, producers never see it change */
+    channel = telemetry_attach(region, size);
+    if (channel == NULL || !atomic_compare_exchange_strong(&g_channel, &expected, channel)) {
+        munmap(region, size);
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * \brief          Loop funtion for printing
  * \return         0
@@ -40,7 +80,14 @@ void *log_loop(void *arg) {
     (void)arg;
     if (fp) {
         while (1) {
+            telemetry_channel_t* channel = atomic_load(&g_channel);
+
             sleep(10);
+            if (channel != NULL) {
+                const char* message = "TestLib has been loaded!";
+                telemetry_push(channel, 0, message, (uint32_t)strlen(message));
+                continue;
+            }
             fprintf(fp, "TestLib has been loaded!\n");
             fflush(fp);
         }